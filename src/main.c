@@ -1,10 +1,17 @@
+#include <math.h>
 #include <raylib.h>
 
 #ifdef PLATFORM_WEB
 #include <emscripten/emscripten.h>
+#include <emscripten/html5.h>
 #endif
 
 #include "res.h" /* Generated file. */
+#include "world.h"
+
+#ifndef PLATFORM_WEB
+#include "versus.h"
+#endif
 
 #define RAYLIB_LOG_LEVEL LOG_ERROR
 
@@ -20,62 +27,59 @@
 #define PLAY_SOUND 1
 #endif
 
-#define SCREEN_WIDTH  480
-#define SCREEN_HEIGHT 854
-#define SCREEN_ZOOM   1.0f
+#ifndef DRAW_NET_STATS
+#define DRAW_NET_STATS 0
+#endif
 
-#define HITBOX_LINE_THICKNESS 2
+#ifndef LOG_FRAME_STATS
+#define LOG_FRAME_STATS 0
+#endif
 
-#define BOUNDARY_TOP    0
-#define BOUNDARY_BOTTOM 100
-#define BOUNDARY_WIDTH  480
-#define BOUNDARY_HEIGHT 854
+#if LOG_FRAME_STATS
+#include <stdio.h>
+#include <time.h>
+#endif
 
-#define BACKGROUND_TEXTURE_COUNT 2
-#define BACKGROUND_TEXTURE_SPEED 50
+#define SCREEN_WIDTH  480
+#define SCREEN_HEIGHT 854
 
-#define BASE_TEXTURE_COUNT 2
+#define RENDER_SCALE_AUTO      0.0f
+#define RENDER_SCALE_PIXEL_ART 0.6f /* 288x512, the size the textures were drawn for */
 
-#define OBSTACLE_WIDTH    90
-#define OBSTACLE_HEIGHT   480
-#define OBSTACLE_PADDING  120
-#define OBSTACLE_MARGIN   180
-#define OBSTACLE_SPEED    170
-#define OBSTACLE_DISTANCE 240
-#define OBSTACLE_COUNT    2
-#define OBSTACLE_FRAC     5
+/* Internal resolution relative to SCREEN_WIDTH x SCREEN_HEIGHT, upscaled to the window in one pass. */
+#ifndef RENDER_SCALE
+#define RENDER_SCALE 1.0f
+#endif
 
-#define BIRD_HIT_RADIUS     20
-#define BIRD_JUMP_FORCE     470
-#define BIRD_ROTATION_SPEED 100
-#define BIRD_ROTATION_MIN   60 /* will be cast to negative */
-#define BIRD_ROTATION_MAX   60
-#define BIRD_INITIAL_SCORE  0
-#define BIRD_COLLISION      1
+#ifndef RENDER_FILTER
+#define RENDER_FILTER TEXTURE_FILTER_BILINEAR
+#endif
 
-#define FLASH_INITIAL_ALPHA 0.8f
-#define FLASH_DECAY_SPEED   17
+/* Only upscale by whole multiples, best with TEXTURE_FILTER_POINT and RENDER_SCALE_PIXEL_ART. */
+#ifndef RENDER_INTEGER_SCALE
+#define RENDER_INTEGER_SCALE 0
+#endif
 
-#define SIMULATION_GRAVITY 1500
+#define RENDER_AUTO_MIN        0.4f
+#define RENDER_AUTO_STEP       0.2f
+#define RENDER_AUTO_FRAMES     120            /* samples per window */
+#define RENDER_AUTO_SLOW       1.25f          /* average over the refresh period that steps down */
+#define RENDER_AUTO_FAST       1.05f          /* average over the refresh period that counts towards stepping up */
+#define RENDER_AUTO_UP_WINDOWS 5              /* fast windows in a row before stepping up */
+#define RENDER_AUTO_UP_MAX     80             /* cap when stepping up keeps being undone */
+#define RENDER_PERIOD_MAX      (1.0f / 50.0f) /* longest refresh period assumed when the monitor reports none */
 
-typedef enum {
-    INTRO,
-    PLAY,
-    OVER,
-} GameMode;
+#define WEB_CANVAS_SELECTOR "#wasm-container"
 
-typedef struct {
-    Vector2 position;
-    Rectangle pipeTop;
-    Rectangle pipeBottom;
-    int passed;
-} Obstacle;
+#define HITBOX_LINE_THICKNESS 2
 
-typedef struct {
-    Vector2 center;
-    float velocity;
-    float rotation;
-} Bird;
+#define FRAME_TIME_MAX       (1.0f / 20.0f)
+#define FRAME_TIME_NOMINAL   (1.0f / 60.0f)
+#define FRAME_WAKE_COUNT     2 /* frames whose measured time still includes the wait for input */
+#define FRAME_STATS_INTERVAL 2.0
+
+#define VERSUS_GHOST_ALPHA      0.5f
+#define VERSUS_STATUS_FONT_SIZE 20
 
 typedef struct {
     Texture2D background;
@@ -100,15 +104,18 @@ typedef struct {
 typedef struct {
     Camera2D camera;
 
-    GameMode mode;
-    unsigned int score;
-
-    Rectangle backgrounds[BACKGROUND_TEXTURE_COUNT];
-    Rectangle bases[BASE_TEXTURE_COUNT];
-    float flashIntensity;
+    World world;
 
-    Obstacle obstacles[OBSTACLE_COUNT];
-    Bird bird;
+    RenderTexture2D target; /* the scene at the internal resolution */
+    int targetIdle;         /* the target holds a static frame that does not need redrawing */
+    int wakeFrames;         /* frames left to step by FRAME_TIME_NOMINAL after leaving idle */
+    float renderScale;
+    float renderTime;    /* sum of the frame times sampled in the current window */
+    float renderTimeMin; /* refresh period estimate when the monitor does not report one */
+    int renderFrames;
+    int renderFastWindows;
+    int renderUpWindows; /* fast windows needed to step up, doubled when a step up is undone */
+    int renderRaised;    /* the last window stepped up */
 
     Textures textures;
     Sounds sounds;
@@ -119,26 +126,56 @@ void GameUnload(Game* game);
 
 void GameReset(Game* game);
 void GameIntroDraw(Game* game);
-void GameIntroUpdate(Game* game, float frameTime);
 void GamePlayDraw(Game* game);
-void GamePlayUpdate(Game* game, float frameTime);
 void GameOverDraw(Game* game);
-void GameOverUpdate(Game* game, float frameTime);
+
+int IsInputReceived(Sounds* sounds);
+void EventsPlay(int events, Sounds* sounds);
+
+int GameIsIdle(Game* game);
+void GameDraw(Game* game);
+void GameRenderScaleSet(Game* game, float scale);
+void GameRenderSamplesReset(Game* game);
+void GameRenderScaleAuto(Game* game, float frameTime);
+
+int ScreenFit(void);
 
 void FrameUpdateDraw(void);
+void FrameStatsLog(int redrawn, int presented);
 
 Game game;
 
-int main(void) {
+#ifndef PLATFORM_WEB
+void VersusDraw(Versus* versus, Textures* textures);
+
+Versus versus;
+#endif
+
+int main(int argc, char** argv) {
+#ifndef PLATFORM_WEB
+    VersusConfig versusConfig;
+    int versusMode = VersusParseArgs(&versusConfig, argc, argv);
+    if (versusMode < 0 || (versusMode && !VersusInit(&versus, versusConfig))) {
+        return 1;
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
+
     SetTraceLogLevel(RAYLIB_LOG_LEVEL);
 
+#ifdef PLATFORM_WEB
     SetConfigFlags(FLAG_VSYNC_HINT);
+#else
+    SetConfigFlags(FLAG_VSYNC_HINT | FLAG_WINDOW_RESIZABLE);
+#endif
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Flappy Bird");
     InitAudioDevice();
 
     GameLoad(&game);
     GameReset(&game);
-    game.mode = INTRO;
+    game.world.mode = INTRO;
 
 #ifdef PLATFORM_WEB
     emscripten_set_main_loop(FrameUpdateDraw, 0, 1);
@@ -149,6 +186,9 @@ int main(void) {
 #endif
 
     GameUnload(&game);
+#ifndef PLATFORM_WEB
+    VersusClose(&versus);
+#endif
 
     CloseAudioDevice();
     CloseWindow();
@@ -157,46 +197,265 @@ int main(void) {
 }
 
 void FrameUpdateDraw(void) {
+    /* Time spent waiting for input shows up in the frame time of the wake frame and the two after it. */
     float frameTime = GetFrameTime();
-    switch (game.mode) {
+    int measured = !game.targetIdle && game.wakeFrames == 0;
+    if (game.targetIdle) {
+        game.wakeFrames = FRAME_WAKE_COUNT;
+        frameTime = FRAME_TIME_NOMINAL;
+        GameRenderSamplesReset(&game);
+    } else if (game.wakeFrames > 0) {
+        game.wakeFrames--;
+        frameTime = FRAME_TIME_NOMINAL;
+    } else if (frameTime > FRAME_TIME_MAX) {
+        frameTime = FRAME_TIME_MAX; /* e.g. while the window is dragged */
+    }
+    int input = IsInputReceived(&game.sounds);
+#ifndef PLATFORM_WEB
+    if (versus.active) {
+        EventsPlay(VersusUpdate(&versus, input, frameTime), &game.sounds);
+        game.world = versus.match.players[versus.local];
+    } else {
+        EventsPlay(WorldUpdate(&game.world, input, frameTime), &game.sounds);
+    }
+#else
+    EventsPlay(WorldUpdate(&game.world, input, frameTime), &game.sounds);
+#endif
+
+    int resized = ScreenFit();
+    int idle = GameIsIdle(&game);
+
+    /* A static frame is drawn once, then only presented while waiting for input. */
+    if (!idle && measured) {
+        GameRenderScaleAuto(&game, GetFrameTime());
+    }
+    int redrawn = !idle || !game.targetIdle;
+    if (redrawn) {
+        BeginTextureMode(game.target);
+        GameDraw(&game);
+        EndTextureMode();
+    }
+    game.targetIdle = idle;
+    if (idle) {
+        EnableEventWaiting();
+    } else {
+        DisableEventWaiting();
+    }
+
+#ifdef PLATFORM_WEB
+    if (!redrawn && !resized) {
+        /* The canvas keeps showing the last frame as long as nothing is drawn. */
+        PollInputEvents();
+        FrameStatsLog(0, 0);
+        return;
+    }
+#else
+    (void)resized;
+#endif
+
+    /* The single upscale pass, letterboxed to keep the aspect ratio. */
+    Texture2D texture = game.target.texture;
+    Vector2 screen = (Vector2){(float)GetScreenWidth(), (float)GetScreenHeight()};
+    float scale = fminf(screen.x / (float)texture.width, screen.y / (float)texture.height);
+#if RENDER_INTEGER_SCALE
+    if (scale >= 1.0f) {
+        scale = floorf(scale);
+    }
+#endif
+    Vector2 size = (Vector2){(float)texture.width * scale, (float)texture.height * scale};
+
+    BeginDrawing();
+    ClearBackground(BLACK);
+    DrawTexturePro(
+        texture,
+        (Rectangle){0.0f, 0.0f, (float)texture.width, -(float)texture.height},
+        (Rectangle){
+            floorf((screen.x - size.x) / 2.0f),
+            floorf((screen.y - size.y) / 2.0f),
+            size.x,
+            size.y,
+        },
+        (Vector2){0.0f, 0.0f},
+        0.0f,
+        WHITE
+    );
+    EndDrawing();
+    FrameStatsLog(redrawn, 1);
+}
+
+/* Returns whether the output size changed. On the web the canvas is sized to the pixels it covers. */
+int ScreenFit(void) {
+#ifdef PLATFORM_WEB
+    double width = 0.0;
+    double height = 0.0;
+    emscripten_get_element_css_size(WEB_CANVAS_SELECTOR, &width, &height);
+    double ratio = emscripten_get_device_pixel_ratio();
+    int screenWidth = (int)(width * ratio);
+    int screenHeight = (int)(height * ratio);
+    if (screenWidth <= 0 || screenHeight <= 0) {
+        return 0;
+    }
+    if (screenWidth == GetScreenWidth() && screenHeight == GetScreenHeight()) {
+        return 0;
+    }
+
+    SetWindowSize(screenWidth, screenHeight);
+    return 1;
+#else
+    return IsWindowResized();
+#endif
+}
+
+int GameIsIdle(Game* game) {
+#ifndef PLATFORM_WEB
+    if (versus.active) {
+        return 0; /* The peer has to be served every frame. */
+    }
+#endif
+
+    return game->world.mode == INTRO || (game->world.mode == OVER && game->world.flashIntensity <= 0.0f);
+}
+
+void GameDraw(Game* game) {
+    ClearBackground(SKYBLUE);
+    BeginMode2D(game->camera);
+    switch (game->world.mode) {
         case INTRO:
-            GameIntroUpdate(&game, frameTime);
+            GameIntroDraw(game);
             break;
         case PLAY:
-            GamePlayUpdate(&game, frameTime);
+            GamePlayDraw(game);
             break;
         case OVER:
-            GameOverUpdate(&game, frameTime);
+            GameOverDraw(game);
             break;
         default:
             break;
     }
+#ifndef PLATFORM_WEB
+    if (versus.active) {
+        VersusDraw(&versus, &game->textures);
+    }
+#endif
+    EndMode2D();
+}
 
-    BeginDrawing();
-    {
-        ClearBackground(SKYBLUE);
-        BeginMode2D(game.camera);
-        switch (game.mode) {
-            case INTRO:
-                GameIntroDraw(&game);
-                break;
-            case PLAY:
-                GamePlayDraw(&game);
-                break;
-            case OVER:
-                GameOverDraw(&game);
-                break;
-            default:
-                break;
+void GameRenderScaleSet(Game* game, float scale) {
+    if (game->target.id != 0) {
+        UnloadRenderTexture(game->target);
+    }
+
+    game->renderScale = scale;
+    game->target = LoadRenderTexture(
+        (int)((float)SCREEN_WIDTH * scale + 0.5f), (int)((float)SCREEN_HEIGHT * scale + 0.5f)
+    );
+    SetTextureFilter(game->target.texture, RENDER_FILTER);
+    game->targetIdle = 0;
+    game->camera.zoom = scale;
+}
+
+void GameRenderSamplesReset(Game* game) {
+    game->renderTime = 0.0f;
+    game->renderTimeMin = FRAME_TIME_MAX;
+    game->renderFrames = 0;
+}
+
+/*
+ * In auto mode, step the internal resolution down while frames keep missing the display refresh, and back up once
+ * they have kept up for a while. The monitor reports no refresh rate on the web, so there the fastest frame of the
+ * window stands in for the refresh period, clamped to RENDER_PERIOD_MAX so steadily slow frames still step down.
+ */
+void GameRenderScaleAuto(Game* game, float frameTime) {
+    if (RENDER_SCALE != RENDER_SCALE_AUTO || frameTime > FRAME_TIME_MAX) {
+        return;
+    }
+
+    game->renderTime += frameTime;
+    game->renderTimeMin = fminf(game->renderTimeMin, frameTime);
+    game->renderFrames++;
+    if (game->renderFrames < RENDER_AUTO_FRAMES) {
+        return;
+    }
+
+    float period = fminf(fmaxf(game->renderTimeMin, FRAME_TIME_NOMINAL), RENDER_PERIOD_MAX);
+#ifndef PLATFORM_WEB
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    if (refreshRate > 0) {
+        period = 1.0f / (float)refreshRate;
+    }
+#endif
+    float average = game->renderTime / (float)game->renderFrames;
+    int raised = game->renderRaised;
+    GameRenderSamplesReset(game);
+    game->renderRaised = 0;
+
+    if (average > period * RENDER_AUTO_SLOW) {
+        game->renderFastWindows = 0;
+        if (raised) {
+            game->renderUpWindows = (int)fminf((float)(game->renderUpWindows * 2), (float)RENDER_AUTO_UP_MAX);
+        }
+        if (game->renderScale > RENDER_AUTO_MIN) {
+            GameRenderScaleSet(game, fmaxf(game->renderScale - RENDER_AUTO_STEP, RENDER_AUTO_MIN));
         }
-        EndMode2D();
+        return;
     }
-    EndDrawing();
+    if (average > period * RENDER_AUTO_FAST || game->renderScale >= 1.0f) {
+        game->renderFastWindows = 0;
+        return;
+    }
+    if (++game->renderFastWindows < game->renderUpWindows) {
+        return;
+    }
+
+    game->renderFastWindows = 0;
+    game->renderRaised = 1;
+    GameRenderScaleSet(game, fminf(game->renderScale + RENDER_AUTO_STEP, 1.0f));
 }
 
-int mod(int a, int n) {
-    return ((a % n) + n) % n;
+#if LOG_FRAME_STATS
+/*
+ * Instrumentation only: prints loop iterations, frames actually presented, full scene redraws and process CPU time.
+ * GPU use is not measured.
+ */
+void FrameStatsLog(int redrawn, int presented) {
+    static double lastTime = 0.0;
+    static clock_t lastClock = 0;
+    static int iterations = 0;
+    static int presents = 0;
+    static int redraws = 0;
+
+    iterations++;
+    presents += presented;
+    redraws += redrawn;
+
+    double now = GetTime();
+    if (now - lastTime < FRAME_STATS_INTERVAL) {
+        return;
+    }
+
+    clock_t cpu = clock();
+    printf(
+        "iterations %d, presented %d, redraws %d, process cpu %.1f%% over %.1fs\n",
+        iterations,
+        presents,
+        redraws,
+        100.0 * ((double)(cpu - lastClock) / CLOCKS_PER_SEC) / (now - lastTime),
+        now - lastTime
+    );
+    fflush(stdout);
+
+    lastTime = now;
+    lastClock = cpu;
+    iterations = 0;
+    presents = 0;
+    redraws = 0;
 }
+#else
+void FrameStatsLog(int redrawn, int presented) {
+    (void)redrawn;
+    (void)presented;
+}
+#endif
 
 int IsInputReceived(Sounds* sounds) {
     int val = IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
@@ -211,7 +470,21 @@ int IsInputReceived(Sounds* sounds) {
     return val;
 }
 
-void BirdDraw(Bird* bird, Textures* textures) {
+void EventsPlay(int events, Sounds* sounds) {
+#if PLAY_SOUND
+    if (events & WORLD_EVENT_POINT) {
+        PlaySound(sounds->point);
+    }
+    if (events & WORLD_EVENT_HIT) {
+        PlaySound(sounds->hit);
+    }
+#else
+    (void)events;
+    (void)sounds;
+#endif
+}
+
+void BirdDraw(Bird* bird, Color tint, Textures* textures) {
 #if DRAW_TEXTURE
     Texture2D* texture = &textures->birdFlapMid;
     if (bird->rotation <= -10.0f) {
@@ -232,9 +505,10 @@ void BirdDraw(Bird* bird, Textures* textures) {
         },
         (Vector2){(float)BIRD_HIT_RADIUS - (adjust.x / 2.0f), BIRD_HIT_RADIUS + adjust.y},
         bird->rotation,
-        WHITE
+        tint
     );
 #else
+    (void)tint;
     (void)textures;
 #endif
 
@@ -245,100 +519,8 @@ void BirdDraw(Bird* bird, Textures* textures) {
 #endif
 }
 
-void BirdUpdate(Bird* bird, int jump, float frameTime) {
-    if (jump) {
-        bird->velocity = -(float)BIRD_JUMP_FORCE;
-        bird->rotation = -(float)BIRD_ROTATION_MIN;
-    } else {
-        bird->velocity += (float)SIMULATION_GRAVITY * frameTime;
-        if (bird->rotation < (float)BIRD_ROTATION_MAX) {
-            bird->rotation += (float)BIRD_ROTATION_SPEED * frameTime;
-        }
-    }
-
-    if (jump || bird->center.y <= BOUNDARY_HEIGHT) {
-        bird->center.y += bird->velocity * frameTime;
-    } else {
-        bird->velocity = 0;
-    }
-}
-
-int BirdIsCollide(Bird* bird, Obstacle* obstacles, int obstacleCount, Sounds* sounds) {
-    int isCollide = 0;
-    if (bird->center.y >= (float)(BOUNDARY_HEIGHT - (BIRD_HIT_RADIUS + BOUNDARY_BOTTOM))) {
-        isCollide = 1;
-        bird->center.y = (float)(BOUNDARY_HEIGHT - (BIRD_HIT_RADIUS + BOUNDARY_BOTTOM));
-    }
-    if (bird->center.y <= (float)(BIRD_HIT_RADIUS + BOUNDARY_TOP)) {
-        isCollide = 1;
-        bird->center.y = (float)(BIRD_HIT_RADIUS + BOUNDARY_TOP);
-    }
-    for (int i = 0; isCollide == 0 && i < obstacleCount; i++) {
-        if (CheckCollisionCircleRec(bird->center, (float)BIRD_HIT_RADIUS, obstacles[i].pipeTop)) {
-            isCollide = 1;
-            break;
-        }
-        if (CheckCollisionCircleRec(bird->center, (float)BIRD_HIT_RADIUS, obstacles[i].pipeBottom)) {
-            isCollide = 1;
-            break;
-        }
-    }
-
-    if (isCollide) {
-#if PLAY_SOUND
-        PlaySound(sounds->hit);
-#else
-        (void)sounds;
-#endif
-    }
-
-#if BIRD_COLLISION
-    return isCollide;
-#else
-    return 0;
-#endif
-}
-
-unsigned int BirdIsPassed(Bird* bird, Obstacle* obstacles, int obstacleCount, Sounds* sounds) {
-    unsigned int passCount = 0;
-
-    for (int i = 0; i < obstacleCount; i++) {
-        if (obstacles[i].passed) {
-            continue;
-        }
-        if (bird->center.x - (float)BIRD_HIT_RADIUS <= obstacles[i].position.x + (float)OBSTACLE_WIDTH) {
-            continue;
-        }
-
-        obstacles[i].passed = 1;
-        passCount++;
-    }
-    if (passCount) {
-#if PLAY_SOUND
-        PlaySound(sounds->point);
-#else
-        (void)sounds;
-#endif
-    }
-
-    return passCount;
-}
-
 void ObstacleDraw(Obstacle* obstacles, int obstacleCount, Textures* textures) {
     for (int i = 0; i < obstacleCount; i++) {
-        obstacles[i].pipeTop = (Rectangle){
-            obstacles[i].position.x,
-            (float)BOUNDARY_TOP,
-            (float)OBSTACLE_WIDTH,
-            obstacles[i].position.y,
-        };
-        obstacles[i].pipeBottom = (Rectangle){
-            obstacles[i].position.x,
-            (float)(BOUNDARY_TOP + obstacles[i].position.y + OBSTACLE_MARGIN),
-            (float)OBSTACLE_WIDTH,
-            (float)((BOUNDARY_HEIGHT - BOUNDARY_BOTTOM) - (obstacles[i].position.y + OBSTACLE_MARGIN)),
-        };
-
 #if DRAW_TEXTURE
         DrawTexturePro(
             textures->pipe,
@@ -382,30 +564,6 @@ void ObstacleDraw(Obstacle* obstacles, int obstacleCount, Textures* textures) {
     }
 }
 
-float GetNextOffset(int step) {
-    float area = (BOUNDARY_HEIGHT - (BOUNDARY_TOP + BOUNDARY_BOTTOM + OBSTACLE_MARGIN + (2.0f * OBSTACLE_PADDING)));
-    return ((area / (float)(OBSTACLE_FRAC)) * (float)step) + (BOUNDARY_TOP + OBSTACLE_PADDING);
-}
-
-void ObstacleUpdate(Obstacle* obstacles, int obstacleCount, float frameTime) {
-    for (int i = 0; i < obstacleCount; i++) {
-        float decrement = (frameTime * (float)OBSTACLE_SPEED);
-        Vector2 nextPosition = (Vector2){
-            obstacles[i].position.x - decrement,
-            obstacles[i].position.y,
-        };
-
-        if (nextPosition.x <= -(float)OBSTACLE_WIDTH) {
-            nextPosition.x = obstacles[mod(i - 1, obstacleCount)].position.x + OBSTACLE_WIDTH + OBSTACLE_DISTANCE;
-            nextPosition.x -= decrement;
-            nextPosition.y = GetNextOffset(GetRandomValue(0, OBSTACLE_FRAC));
-            obstacles[i].passed = 0;
-        }
-
-        obstacles[i].position = nextPosition;
-    }
-}
-
 void BaseDraw(Rectangle* bases, int baseCount, Textures* textures) {
     for (int i = 0; i < baseCount; i++) {
 #if DRAW_TEXTURE
@@ -433,18 +591,6 @@ void BaseDraw(Rectangle* bases, int baseCount, Textures* textures) {
     }
 }
 
-void BaseUpdate(Rectangle* bases, int baseCount, float frameTime) {
-    for (int i = 0; i < baseCount; i++) {
-        float decrement = (frameTime * (float)OBSTACLE_SPEED);
-        float nextX = bases[i].x - decrement;
-        if (nextX <= -(float)BOUNDARY_WIDTH) {
-            nextX = bases[mod(i - 1, baseCount)].x + (float)BOUNDARY_WIDTH - decrement;
-        }
-
-        bases[i].x = nextX;
-    }
-}
-
 void BackgroundDraw(Rectangle* backgrounds, int backgroundCount, Textures* textures) {
     for (int i = 0; i < backgroundCount; i++) {
 #if DRAW_TEXTURE
@@ -472,60 +618,11 @@ void BackgroundDraw(Rectangle* backgrounds, int backgroundCount, Textures* textu
 #endif
 }
 
-void BackgroundUpdate(Rectangle* backgrounds, int backgroundCount, float frameTime) {
-    for (int i = 0; i < backgroundCount; i++) {
-        float decrement = frameTime * (float)BACKGROUND_TEXTURE_SPEED;
-        float nextX = backgrounds[i].x - decrement;
-        if (nextX <= -(float)BOUNDARY_WIDTH) {
-            nextX = backgrounds[mod(i - 1, backgroundCount)].x + (float)BOUNDARY_WIDTH - decrement;
-        }
-
-        backgrounds[i].x = nextX;
-    }
-}
-
 void GameReset(Game* game) {
     game->camera = (Camera2D){0};
-    game->camera.zoom = SCREEN_ZOOM;
-    game->camera.offset = (Vector2){
-        (float)SCREEN_WIDTH * (float)SCREEN_ZOOM,
-        (float)SCREEN_HEIGHT * (float)SCREEN_ZOOM,
-    };
-    game->camera.target = (Vector2){
-        (float)SCREEN_WIDTH * (float)SCREEN_ZOOM,
-        (float)SCREEN_HEIGHT * (float)SCREEN_ZOOM,
-    };
-
-    for (int i = 0; i < BACKGROUND_TEXTURE_COUNT; i++) {
-        game->backgrounds[i] = (Rectangle){
-            (float)i * (float)BOUNDARY_WIDTH,
-            0.0f,
-            (float)BOUNDARY_WIDTH,
-            (float)(BOUNDARY_HEIGHT - BOUNDARY_BOTTOM),
-        };
-    }
-    for (int i = 0; i < BASE_TEXTURE_COUNT; i++) {
-        game->bases[i] = (Rectangle){
-            (float)i * (float)BOUNDARY_WIDTH,
-            (float)(BOUNDARY_HEIGHT - BOUNDARY_BOTTOM),
-            (float)BOUNDARY_WIDTH,
-            (float)BOUNDARY_BOTTOM,
-        };
-    }
-
-    game->obstacles[0] = (Obstacle){0};
-    game->obstacles[0].position.y = GetNextOffset(OBSTACLE_FRAC / 2 + 1);
-    game->obstacles[0].position.x = (float)BOUNDARY_WIDTH;
-    for (int i = 1; i < OBSTACLE_COUNT; i++) {
-        game->obstacles[i] = (Obstacle){0};
-        game->obstacles[i].position.y = GetNextOffset(OBSTACLE_FRAC / 2 + 1);
-        game->obstacles[i].position.x = game->obstacles[i - 1].position.x + OBSTACLE_WIDTH + OBSTACLE_DISTANCE;
-    }
-
-    game->bird = (Bird){0};
-    game->bird.center = (Vector2){(float)BOUNDARY_WIDTH / 2.0f, (float)BOUNDARY_HEIGHT / 2.0f};
+    game->camera.zoom = game->renderScale;
 
-    game->score = BIRD_INITIAL_SCORE;
+    WorldReset(&game->world);
 }
 
 void ScoreDraw(unsigned int score, Vector2 pos, Textures* textures) {
@@ -574,8 +671,8 @@ void ScoreDraw(unsigned int score, Vector2 pos, Textures* textures) {
 }
 
 void GameIntroDraw(Game* game) {
-    BackgroundDraw(game->backgrounds, 2, &game->textures);
-    BaseDraw(game->bases, 2, &game->textures);
+    BackgroundDraw(game->world.backgrounds, 2, &game->textures);
+    BaseDraw(game->world.bases, 2, &game->textures);
 
 #if DRAW_TEXTURE
     float marginTop = 30.0f;
@@ -595,47 +692,24 @@ void GameIntroDraw(Game* game) {
     );
 #endif
 
-    ScoreDraw(game->score, (Vector2){10.0f, 10.0f}, &game->textures);
-}
-
-void GameIntroUpdate(Game* game, float frameTime) {
-    if (!IsInputReceived(&game->sounds)) {
-        return;
-    }
-
-    BirdUpdate(&game->bird, 1, frameTime);
-    game->mode = PLAY;
+    ScoreDraw(game->world.score, (Vector2){10.0f, 10.0f}, &game->textures);
 }
 
 void GamePlayDraw(Game* game) {
-    BackgroundDraw(game->backgrounds, BACKGROUND_TEXTURE_COUNT, &game->textures);
-    ObstacleDraw(game->obstacles, OBSTACLE_COUNT, &game->textures);
-    BaseDraw(game->bases, BASE_TEXTURE_COUNT, &game->textures);
-
-    BirdDraw(&game->bird, &game->textures);
+    BackgroundDraw(game->world.backgrounds, BACKGROUND_TEXTURE_COUNT, &game->textures);
+    ObstacleDraw(game->world.obstacles, OBSTACLE_COUNT, &game->textures);
+    BaseDraw(game->world.bases, BASE_TEXTURE_COUNT, &game->textures);
 
-    ScoreDraw(game->score, (Vector2){10.0f, 10.0f}, &game->textures);
-}
-
-void GamePlayUpdate(Game* game, float frameTime) {
-    BackgroundUpdate(game->backgrounds, BACKGROUND_TEXTURE_COUNT, frameTime);
-    BaseUpdate(game->bases, BASE_TEXTURE_COUNT, frameTime);
+    BirdDraw(&game->world.bird, WHITE, &game->textures);
 
-    ObstacleUpdate(game->obstacles, OBSTACLE_COUNT, frameTime);
-
-    BirdUpdate(&game->bird, IsInputReceived(&game->sounds), frameTime);
-    game->score += BirdIsPassed(&game->bird, game->obstacles, OBSTACLE_COUNT, &game->sounds);
-    if (BirdIsCollide(&game->bird, game->obstacles, OBSTACLE_COUNT, &game->sounds)) {
-        game->flashIntensity = FLASH_INITIAL_ALPHA;
-        game->mode = OVER;
-    }
+    ScoreDraw(game->world.score, (Vector2){10.0f, 10.0f}, &game->textures);
 }
 
 void GameOverDraw(Game* game) {
     GamePlayDraw(game);
 
 #if DRAW_TEXTURE
-    DrawRectangle(0.0f, 0.0f, BOUNDARY_WIDTH, BOUNDARY_HEIGHT, Fade(WHITE, game->flashIntensity));
+    DrawRectangle(0.0f, 0.0f, BOUNDARY_WIDTH, BOUNDARY_HEIGHT, Fade(WHITE, game->world.flashIntensity));
 
     float marginTop = 120.0f;
     Vector2 size = (Vector2){300.0f, 70.0f};
@@ -650,21 +724,48 @@ void GameOverDraw(Game* game) {
 #endif
 }
 
-void GameOverUpdate(Game* game, float frameTime) {
-    if (game->flashIntensity >= 0.0f) {
-        game->flashIntensity -= (float)FLASH_DECAY_SPEED * frameTime;
-    } else {
-        game->flashIntensity = 0.0f;
+#ifndef PLATFORM_WEB
+/* The other player is drawn as a ghost over the local game, with their score under ours. */
+void VersusDraw(Versus* versus, Textures* textures) {
+    World* local = &versus->match.players[versus->local];
+    World* remote = &versus->match.players[1 - versus->local];
+
+    const char* status = VersusStatus(versus, GetTime());
+    if (status) {
+        int width = MeasureText(status, VERSUS_STATUS_FONT_SIZE);
+        DrawText(
+            status,
+            (BOUNDARY_WIDTH - width) / 2,
+            BOUNDARY_HEIGHT - (BOUNDARY_BOTTOM / 2) - (VERSUS_STATUS_FONT_SIZE / 2),
+            VERSUS_STATUS_FONT_SIZE,
+            WHITE
+        );
     }
-
-    if (!IsInputReceived(&game->sounds)) {
+    if (local->mode == INTRO) {
         return;
     }
 
-    GameReset(game);
-    BirdUpdate(&game->bird, 1, frameTime);
-    game->mode = PLAY;
+    BirdDraw(&remote->bird, Fade(WHITE, VERSUS_GHOST_ALPHA), textures);
+    ScoreDraw(remote->score, (Vector2){10.0f, 55.0f}, textures);
+
+#if DRAW_NET_STATS
+    DrawText(
+        TextFormat(
+            "tick %d  confirmed %d  rollbacks %d  max %d ticks / %.3f ms",
+            versus->tick,
+            versus->remoteTick,
+            versus->rollbackCount,
+            versus->rollbackTicks,
+            versus->rollbackTime * 1000.0
+        ),
+        10,
+        BOUNDARY_HEIGHT - 20,
+        10,
+        DARKGRAY
+    );
+#endif
 }
+#endif
 
 void TextureFromPngMemory(Texture2D* texture, const unsigned char* data, int length) {
     Image image = LoadImageFromMemory(".png", data, length);
@@ -680,6 +781,7 @@ void SoundFromWavMemory(Sound* sound, const unsigned char* data, int length) {
 
 void GameLoad(Game* game) {
     *game = (Game){0};
+    WorldInit(&game->world, PHYSICS_DEFAULT, (unsigned int)GetRandomValue(1, 0x7fffffff));
 
     TextureFromPngMemory(&game->textures.background, res_textures_bg_png, res_textures_bg_png_len);
     TextureFromPngMemory(&game->textures.base, res_textures_base_png, res_textures_base_png_len);
@@ -705,6 +807,10 @@ void GameLoad(Game* game) {
     SoundFromWavMemory(&game->sounds.flap, res_sounds_flap_wav, res_sounds_flap_wav_len);
     SoundFromWavMemory(&game->sounds.point, res_sounds_point_wav, res_sounds_point_wav_len);
     SoundFromWavMemory(&game->sounds.hit, res_sounds_hit_wav, res_sounds_hit_wav_len);
+
+    GameRenderScaleSet(game, RENDER_SCALE == RENDER_SCALE_AUTO ? 1.0f : RENDER_SCALE);
+    GameRenderSamplesReset(game);
+    game->renderUpWindows = RENDER_AUTO_UP_WINDOWS;
 }
 
 void GameUnload(Game* game) {
@@ -732,4 +838,6 @@ void GameUnload(Game* game) {
     UnloadSound(game->sounds.flap);
     UnloadSound(game->sounds.point);
     UnloadSound(game->sounds.hit);
+
+    UnloadRenderTexture(game->target);
 }
@@ -0,0 +1,407 @@
+#include "versus.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+void MatchInit(Match* match, unsigned int seed) {
+    *match = (Match){0};
+    match->seed = seed;
+    for (int i = 0; i < VERSUS_PLAYER_COUNT; i++) {
+        WorldInit(&match->players[i], PHYSICS_DEFAULT, seed);
+    }
+}
+
+/* Both birds leave the intro together and a new round only starts once both are down, so the courses stay in step. */
+void MatchUpdate(Match* match, const int* inputs, int* events, float frameTime) {
+    int anyInput = 0;
+    int introCount = 0;
+    int overCount = 0;
+    for (int i = 0; i < VERSUS_PLAYER_COUNT; i++) {
+        anyInput |= inputs[i];
+        introCount += match->players[i].mode == INTRO;
+        overCount += match->players[i].mode == OVER;
+        events[i] = WORLD_EVENT_NONE;
+    }
+
+    if (overCount == VERSUS_PLAYER_COUNT && anyInput) {
+        match->round++;
+        for (int i = 0; i < VERSUS_PLAYER_COUNT; i++) {
+            WorldInit(&match->players[i], match->players[i].physics, match->seed + match->round * 0x9e3779b9u);
+        }
+        introCount = VERSUS_PLAYER_COUNT;
+    }
+    if (introCount == VERSUS_PLAYER_COUNT) {
+        for (int i = 0; anyInput && i < VERSUS_PLAYER_COUNT; i++) {
+            events[i] = WorldUpdate(&match->players[i], 1, frameTime);
+        }
+        return;
+    }
+
+    for (int i = 0; i < VERSUS_PLAYER_COUNT; i++) {
+        World* world = &match->players[i];
+        events[i] = WorldUpdate(world, world->mode == OVER ? 0 : inputs[i], frameTime);
+    }
+}
+
+void Put32(unsigned char* data, uint32_t value) {
+    data[0] = (unsigned char)(value >> 24);
+    data[1] = (unsigned char)(value >> 16);
+    data[2] = (unsigned char)(value >> 8);
+    data[3] = (unsigned char)value;
+}
+
+uint32_t Get32(const unsigned char* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+int LinkOpen(VersusLink* link, VersusConfig config) {
+    *link = (VersusLink){0};
+    link->latency = config.latency;
+    link->loss = config.loss;
+
+    struct sockaddr_in local = {0};
+    local.sin_family = AF_INET;
+    local.sin_port = htons((uint16_t)config.localPort);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    link->remote.sin_family = AF_INET;
+    link->remote.sin_port = htons((uint16_t)config.remotePort);
+    if (inet_pton(AF_INET, config.host, &link->remote.sin_addr) != 1) {
+        fprintf(stderr, "versus: invalid host %s\n", config.host);
+        return 0;
+    }
+
+    link->socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (link->socket < 0) {
+        perror("versus: socket");
+        return 0;
+    }
+    if (bind(link->socket, (struct sockaddr*)&local, sizeof(local)) < 0) {
+        perror("versus: bind");
+        close(link->socket);
+        return 0;
+    }
+    fcntl(link->socket, F_SETFL, fcntl(link->socket, F_GETFL, 0) | O_NONBLOCK);
+
+    return 1;
+}
+
+void LinkFlush(VersusLink* link, double now) {
+    for (; link->queueCount > 0; link->queueCount--) {
+        VersusPacket* packet = &link->queue[link->queueHead];
+        if (packet->sendAt > now) {
+            break;
+        }
+
+        sendto(
+            link->socket,
+            packet->data,
+            VERSUS_PACKET_SIZE,
+            0,
+            (struct sockaddr*)&link->remote,
+            sizeof(link->remote)
+        );
+        link->queueHead = (link->queueHead + 1) % VERSUS_QUEUE_MAX;
+    }
+}
+
+/* Injected loss drops the packet here, injected latency holds it in the queue until it is due. */
+void LinkSend(VersusLink* link, const unsigned char* data, double now) {
+    if (link->loss > 0.0f && (float)rand() / (float)RAND_MAX < link->loss) {
+        return;
+    }
+    if (link->queueCount == VERSUS_QUEUE_MAX) {
+        return;
+    }
+
+    VersusPacket* packet = &link->queue[(link->queueHead + link->queueCount) % VERSUS_QUEUE_MAX];
+    packet->sendAt = now + (double)link->latency;
+    memcpy(packet->data, data, VERSUS_PACKET_SIZE);
+    link->queueCount++;
+
+    LinkFlush(link, now);
+}
+
+int LinkReceive(VersusLink* link, unsigned char* data) {
+    for (;;) {
+        ssize_t length = recv(link->socket, data, VERSUS_PACKET_SIZE, 0);
+        if (length < 0) {
+            return 0;
+        }
+        if (length == VERSUS_PACKET_SIZE && Get32(data) == VERSUS_PACKET_MAGIC) {
+            return 1;
+        }
+    }
+}
+
+void VersusUsage(const char* program) {
+    fprintf(
+        stderr,
+        "usage: %s [--versus LOCAL_PORT REMOTE_PORT [--host ADDRESS] [--latency MS] [--loss PERCENT]]\n"
+        "Ports are 1-65535 and must differ, latency is 0-%.0f ms and loss 0-100%%.\n",
+        program,
+        VERSUS_LATENCY_MAX
+    );
+}
+
+/* Ports must be whole numbers a socket can bind, anything else would be truncated by htons. */
+int PortParse(const char* text, int* port) {
+    char* end = NULL;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 1 || value > 65535) {
+        return 0;
+    }
+
+    *port = (int)value;
+    return 1;
+}
+
+int NumberParse(const char* text, double min, double max, double* number) {
+    char* end = NULL;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || !(value >= min && value <= max)) {
+        return 0;
+    }
+
+    *number = value;
+    return 1;
+}
+
+/*
+ * Returns 1 for a versus game, 0 for a normal one and -1 on bad arguments. Only the versus flags are checked, other
+ * arguments are left to the platform and ignored.
+ */
+int VersusParseArgs(VersusConfig* config, int argc, char** argv) {
+    *config = (VersusConfig){VERSUS_DEFAULT_HOST, 0, 0, 0.0f, 0.0f};
+
+    int versus = 0;
+    int valid = 1;
+    double number = 0.0;
+    for (int i = 1; i < argc && valid; i++) {
+        if (strcmp(argv[i], "--versus") == 0) {
+            valid = i + 2 < argc && PortParse(argv[i + 1], &config->localPort) &&
+                    PortParse(argv[i + 2], &config->remotePort) && config->localPort != config->remotePort;
+            versus = 1;
+            i += 2;
+        } else if (strcmp(argv[i], "--host") == 0) {
+            valid = i + 1 < argc;
+            config->host = valid ? argv[++i] : config->host;
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            valid = i + 1 < argc && NumberParse(argv[++i], 0.0, VERSUS_LATENCY_MAX, &number);
+            config->latency = (float)(number / 1000.0);
+        } else if (strcmp(argv[i], "--loss") == 0) {
+            valid = i + 1 < argc && NumberParse(argv[++i], 0.0, 100.0, &number);
+            config->loss = (float)(number / 100.0);
+        }
+    }
+    if (!valid) {
+        VersusUsage(argv[0]);
+        return -1;
+    }
+
+    return versus;
+}
+
+int VersusInit(Versus* versus, VersusConfig config) {
+    *versus = (Versus){0};
+    if (!LinkOpen(&versus->link, config)) {
+        return 0;
+    }
+
+    /* Both sides derive the player order and the course from the port pair, so no handshake is needed. */
+    int lowPort = config.localPort < config.remotePort ? config.localPort : config.remotePort;
+    int highPort = config.localPort < config.remotePort ? config.remotePort : config.localPort;
+    versus->local = config.localPort == lowPort ? 0 : 1;
+    MatchInit(&versus->match, ((unsigned int)lowPort << 16) ^ (unsigned int)highPort);
+
+    /* Inputs for the first ticks are known to be empty on both sides. */
+    versus->tick = 0;
+    versus->remoteTick = VERSUS_INPUT_DELAY;
+    versus->ackTick = VERSUS_INPUT_DELAY;
+    versus->active = 1;
+
+    return 1;
+}
+
+void VersusClose(Versus* versus) {
+    if (!versus->active) {
+        return;
+    }
+
+    close(versus->link.socket);
+    versus->active = 0;
+}
+
+int VersusInput(Versus* versus, int player, int tick) {
+    if (player != versus->local && tick >= versus->remoteTick) {
+        return 0; /* Predict no flap, it is by far the most common input. */
+    }
+
+    return versus->inputs[player][tick % VERSUS_INPUT_WINDOW];
+}
+
+int VersusStep(Versus* versus) {
+    int inputs[VERSUS_PLAYER_COUNT];
+    int events[VERSUS_PLAYER_COUNT];
+    for (int i = 0; i < VERSUS_PLAYER_COUNT; i++) {
+        inputs[i] = VersusInput(versus, i, versus->tick);
+    }
+
+    versus->snapshots[versus->tick % (VERSUS_ROLLBACK_MAX + 1)] = versus->match;
+    MatchUpdate(&versus->match, inputs, events, VERSUS_TICK_TIME);
+    versus->tick++;
+
+    return events[versus->local];
+}
+
+/* Restore the state before the first mispredicted tick and simulate back up to the present, events are dropped. */
+void VersusRollback(Versus* versus, int from) {
+    double start = GetTime();
+
+    int tick = versus->tick;
+    versus->match = versus->snapshots[from % (VERSUS_ROLLBACK_MAX + 1)];
+    for (versus->tick = from; versus->tick < tick;) {
+        VersusStep(versus);
+    }
+
+    double elapsed = GetTime() - start;
+    versus->rollbackCount++;
+    if (tick - from > versus->rollbackTicks) {
+        versus->rollbackTicks = tick - from;
+    }
+    if (elapsed > versus->rollbackTime) {
+        versus->rollbackTime = elapsed;
+    }
+}
+
+void VersusReceive(Versus* versus, double now) {
+    int remote = 1 - versus->local;
+    int rollbackFrom = versus->tick;
+
+    unsigned char data[VERSUS_PACKET_SIZE];
+    while (LinkReceive(&versus->link, data)) {
+        versus->peerSeen = 1;
+        versus->receivedAt = now;
+
+        int peerTick = (int)Get32(&data[4]);
+        int peerAdvantage = (int)(int32_t)Get32(&data[8]);
+        int start = (int)Get32(&data[12]);
+        int ack = (int)Get32(&data[16]);
+        int count = (int)Get32(&data[20]);
+        uint64_t bits = ((uint64_t)Get32(&data[24]) << 32) | (uint64_t)Get32(&data[28]);
+
+        if (peerTick >= versus->peerTick) {
+            versus->peerTick = peerTick;
+            versus->peerAdvantage = peerAdvantage;
+        }
+        if (ack > versus->ackTick) {
+            versus->ackTick = ack;
+        }
+
+        /* Packets resend everything unacknowledged, so only the next expected tick onwards is new. */
+        for (int i = 0; i < count && i < VERSUS_INPUT_WINDOW; i++) {
+            int tick = start + i;
+            if (tick != versus->remoteTick) {
+                continue;
+            }
+
+            int value = (int)((bits >> i) & 1u);
+            versus->inputs[remote][tick % VERSUS_INPUT_WINDOW] = (unsigned char)value;
+            versus->remoteTick++;
+            if (value && tick < rollbackFrom) {
+                rollbackFrom = tick;
+            }
+        }
+    }
+
+    if (rollbackFrom < versus->tick) {
+        VersusRollback(versus, rollbackFrom);
+    }
+}
+
+void VersusSend(Versus* versus, double now) {
+    int inputEnd = versus->tick + VERSUS_INPUT_DELAY;
+    int count = inputEnd - versus->ackTick;
+    if (count > VERSUS_INPUT_WINDOW) {
+        count = VERSUS_INPUT_WINDOW;
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < count; i++) {
+        bits |= (uint64_t)versus->inputs[versus->local][(versus->ackTick + i) % VERSUS_INPUT_WINDOW] << i;
+    }
+
+    unsigned char data[VERSUS_PACKET_SIZE];
+    Put32(&data[0], VERSUS_PACKET_MAGIC);
+    Put32(&data[4], (uint32_t)versus->tick);
+    Put32(&data[8], (uint32_t)(int32_t)(versus->tick - versus->peerTick));
+    Put32(&data[12], (uint32_t)versus->ackTick);
+    Put32(&data[16], (uint32_t)versus->remoteTick);
+    Put32(&data[20], (uint32_t)count);
+    Put32(&data[24], (uint32_t)(bits >> 32));
+    Put32(&data[28], (uint32_t)bits);
+
+    LinkSend(&versus->link, data, now);
+}
+
+int VersusUpdate(Versus* versus, int input, float frameTime) {
+    int events = WORLD_EVENT_NONE;
+    double now = GetTime();
+
+    versus->pendingInput |= input;
+    VersusReceive(versus, now);
+
+    versus->accumulator += frameTime;
+    if (versus->accumulator > VERSUS_TICK_TIME * (float)VERSUS_TICK_MAX) {
+        versus->accumulator = VERSUS_TICK_TIME * (float)VERSUS_TICK_MAX;
+    }
+
+    /*
+     * Both advantages are equally stale, so their difference is twice how far we are ahead. The side that is ahead
+     * gives up a tick now and then, otherwise the other side would keep rolling back.
+     */
+    int advantage = (versus->tick - versus->peerTick) - versus->peerAdvantage;
+    if (versus->syncWait > 0) {
+        versus->syncWait--;
+    } else if (advantage >= 4 && versus->accumulator >= VERSUS_TICK_TIME) {
+        versus->accumulator -= VERSUS_TICK_TIME;
+        versus->syncWait = VERSUS_SYNC_INTERVAL;
+    }
+
+    for (; versus->accumulator >= VERSUS_TICK_TIME; versus->accumulator -= VERSUS_TICK_TIME) {
+        if (versus->tick - versus->remoteTick >= VERSUS_ROLLBACK_MAX) {
+            break; /* Too far past the last confirmed remote input, wait for it. */
+        }
+        if (versus->tick + VERSUS_INPUT_DELAY - versus->ackTick >= VERSUS_INPUT_WINDOW) {
+            break;
+        }
+
+        versus->inputs[versus->local][(versus->tick + VERSUS_INPUT_DELAY) % VERSUS_INPUT_WINDOW] =
+            (unsigned char)versus->pendingInput;
+        versus->pendingInput = 0;
+        events |= VersusStep(versus);
+    }
+
+    VersusSend(versus, now);
+    LinkFlush(&versus->link, now);
+
+    return events;
+}
+
+/* Returns a message to show while the peer is missing, NULL while packets keep arriving. */
+const char* VersusStatus(Versus* versus, double now) {
+    if (!versus->peerSeen) {
+        return "waiting for peer";
+    }
+    if (now - versus->receivedAt > VERSUS_PEER_TIMEOUT) {
+        return "peer disconnected";
+    }
+
+    return NULL;
+}
@@ -0,0 +1,87 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include <netinet/in.h>
+
+#include "world.h"
+
+#define VERSUS_PLAYER_COUNT  2
+#define VERSUS_TICK_TIME     (1.0f / 60.0f)
+#define VERSUS_TICK_MAX      4  /* per frame, when catching up */
+#define VERSUS_INPUT_DELAY   2  /* ticks */
+#define VERSUS_ROLLBACK_MAX  12 /* ticks the local side may run ahead of confirmed remote input */
+#define VERSUS_INPUT_WINDOW  64 /* must cover everything unacknowledged, packets carry one bit per tick */
+#define VERSUS_SYNC_INTERVAL 10 /* frames between giving up a tick to a peer that is behind */
+#define VERSUS_QUEUE_MAX     256
+#define VERSUS_PACKET_SIZE   32
+#define VERSUS_PACKET_MAGIC  0x464c4150u
+#define VERSUS_DEFAULT_HOST  "127.0.0.1"
+#define VERSUS_PEER_TIMEOUT  2.0 /* seconds without packets before the peer counts as gone */
+#define VERSUS_LATENCY_MAX   10000.0 /* milliseconds accepted by --latency */
+
+typedef struct {
+    World players[VERSUS_PLAYER_COUNT];
+    unsigned int seed;
+    unsigned int round;
+} Match;
+
+typedef struct {
+    const char* host;
+    int localPort;
+    int remotePort;
+    float latency; /* seconds, added to every outgoing packet */
+    float loss;    /* 0..1, chance an outgoing packet is dropped */
+} VersusConfig;
+
+typedef struct {
+    double sendAt;
+    unsigned char data[VERSUS_PACKET_SIZE];
+} VersusPacket;
+
+typedef struct {
+    int socket;
+    struct sockaddr_in remote;
+    float latency;
+    float loss;
+
+    VersusPacket queue[VERSUS_QUEUE_MAX];
+    int queueHead;
+    int queueCount;
+} VersusLink;
+
+typedef struct {
+    int active;
+    int local;
+
+    Match match;
+    Match snapshots[VERSUS_ROLLBACK_MAX + 1]; /* state before each of the last ticks, indexed by tick */
+    unsigned char inputs[VERSUS_PLAYER_COUNT][VERSUS_INPUT_WINDOW];
+
+    int tick;       /* next tick to simulate */
+    int remoteTick; /* remote inputs are confirmed below this */
+    int ackTick;    /* the remote has confirmed our inputs below this */
+    int peerTick;   /* latest tick the remote reported simulating */
+    int peerAdvantage;
+    int syncWait;
+    int pendingInput;
+    int peerSeen;
+    double receivedAt;
+    float accumulator;
+
+    int rollbackCount;
+    int rollbackTicks;
+    double rollbackTime;
+
+    VersusLink link;
+} Versus;
+
+void MatchInit(Match* match, unsigned int seed);
+void MatchUpdate(Match* match, const int* inputs, int* events, float frameTime);
+
+int VersusParseArgs(VersusConfig* config, int argc, char** argv);
+int VersusInit(Versus* versus, VersusConfig config);
+void VersusClose(Versus* versus);
+int VersusUpdate(Versus* versus, int input, float frameTime);
+const char* VersusStatus(Versus* versus, double now);
+
+#endif
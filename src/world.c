@@ -0,0 +1,263 @@
+#include "world.h"
+
+int mod(int a, int n) {
+    return ((a % n) + n) % n;
+}
+
+/* xorshift32, kept in the world so runs are reproducible and independent of each other. */
+int WorldRandomValue(World* world, int min, int max) {
+    unsigned int x = world->seed ? world->seed : WORLD_DEFAULT_SEED;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    world->seed = x;
+
+    return min + (int)(x % (unsigned int)(max - min + 1));
+}
+
+void BirdUpdate(Bird* bird, int jump, float frameTime, Physics* physics) {
+    if (jump) {
+        bird->velocity = -PHYSICS_JUMP_FORCE(physics);
+        bird->rotation = -(float)BIRD_ROTATION_MIN;
+    } else {
+        bird->velocity += PHYSICS_GRAVITY(physics) * frameTime;
+        if (bird->rotation < (float)BIRD_ROTATION_MAX) {
+            bird->rotation += (float)BIRD_ROTATION_SPEED * frameTime;
+        }
+    }
+
+    if (jump || bird->center.y <= BOUNDARY_HEIGHT) {
+        bird->center.y += bird->velocity * frameTime;
+    } else {
+        bird->velocity = 0;
+    }
+}
+
+int BirdIsCollide(Bird* bird, Obstacle* obstacles, int obstacleCount) {
+    int isCollide = 0;
+    if (bird->center.y >= (float)(BOUNDARY_HEIGHT - (BIRD_HIT_RADIUS + BOUNDARY_BOTTOM))) {
+        isCollide = 1;
+        bird->center.y = (float)(BOUNDARY_HEIGHT - (BIRD_HIT_RADIUS + BOUNDARY_BOTTOM));
+    }
+    if (bird->center.y <= (float)(BIRD_HIT_RADIUS + BOUNDARY_TOP)) {
+        isCollide = 1;
+        bird->center.y = (float)(BIRD_HIT_RADIUS + BOUNDARY_TOP);
+    }
+    for (int i = 0; isCollide == 0 && i < obstacleCount; i++) {
+        if (CheckCollisionCircleRec(bird->center, (float)BIRD_HIT_RADIUS, obstacles[i].pipeTop)) {
+            isCollide = 1;
+            break;
+        }
+        if (CheckCollisionCircleRec(bird->center, (float)BIRD_HIT_RADIUS, obstacles[i].pipeBottom)) {
+            isCollide = 1;
+            break;
+        }
+    }
+
+    return isCollide;
+}
+
+unsigned int BirdIsPassed(Bird* bird, Obstacle* obstacles, int obstacleCount) {
+    unsigned int passCount = 0;
+
+    for (int i = 0; i < obstacleCount; i++) {
+        if (obstacles[i].passed) {
+            continue;
+        }
+        if (bird->center.x - (float)BIRD_HIT_RADIUS <= obstacles[i].position.x + (float)OBSTACLE_WIDTH) {
+            continue;
+        }
+
+        obstacles[i].passed = 1;
+        passCount++;
+    }
+
+    return passCount;
+}
+
+float GetNextOffset(int step, Physics* physics) {
+    float area = (BOUNDARY_HEIGHT - (BOUNDARY_TOP + BOUNDARY_BOTTOM + PHYSICS_OBSTACLE_MARGIN(physics) +
+                                     (2.0f * OBSTACLE_PADDING)));
+    return ((area / (float)PHYSICS_OBSTACLE_FRAC(physics)) * (float)step) + (BOUNDARY_TOP + OBSTACLE_PADDING);
+}
+
+void ObstacleHitboxUpdate(Obstacle* obstacles, int obstacleCount, Physics* physics) {
+    for (int i = 0; i < obstacleCount; i++) {
+        obstacles[i].pipeTop = (Rectangle){
+            obstacles[i].position.x,
+            (float)BOUNDARY_TOP,
+            (float)OBSTACLE_WIDTH,
+            obstacles[i].position.y,
+        };
+        obstacles[i].pipeBottom = (Rectangle){
+            obstacles[i].position.x,
+            (float)BOUNDARY_TOP + obstacles[i].position.y + PHYSICS_OBSTACLE_MARGIN(physics),
+            (float)OBSTACLE_WIDTH,
+            (float)(BOUNDARY_HEIGHT - BOUNDARY_BOTTOM) -
+                (obstacles[i].position.y + PHYSICS_OBSTACLE_MARGIN(physics)),
+        };
+    }
+}
+
+void ObstacleUpdate(World* world, float frameTime) {
+    Obstacle* obstacles = world->obstacles;
+    Physics* physics = &world->physics;
+    for (int i = 0; i < OBSTACLE_COUNT; i++) {
+        float decrement = (frameTime * PHYSICS_OBSTACLE_SPEED(physics));
+        Vector2 nextPosition = (Vector2){
+            obstacles[i].position.x - decrement,
+            obstacles[i].position.y,
+        };
+
+        if (nextPosition.x <= -(float)OBSTACLE_WIDTH) {
+            nextPosition.x = obstacles[mod(i - 1, OBSTACLE_COUNT)].position.x + OBSTACLE_WIDTH +
+                             PHYSICS_OBSTACLE_DISTANCE(physics);
+            nextPosition.x -= decrement;
+            nextPosition.y =
+                GetNextOffset(WorldRandomValue(world, 0, PHYSICS_OBSTACLE_FRAC(physics)), physics);
+            obstacles[i].passed = 0;
+        }
+
+        obstacles[i].position = nextPosition;
+    }
+
+    ObstacleHitboxUpdate(obstacles, OBSTACLE_COUNT, physics);
+}
+
+void BaseUpdate(Rectangle* bases, int baseCount, float frameTime, Physics* physics) {
+    for (int i = 0; i < baseCount; i++) {
+        float decrement = (frameTime * PHYSICS_OBSTACLE_SPEED(physics));
+        float nextX = bases[i].x - decrement;
+        if (nextX <= -(float)BOUNDARY_WIDTH) {
+            nextX = bases[mod(i - 1, baseCount)].x + (float)BOUNDARY_WIDTH - decrement;
+        }
+
+        bases[i].x = nextX;
+    }
+}
+
+void BackgroundUpdate(Rectangle* backgrounds, int backgroundCount, float frameTime) {
+    for (int i = 0; i < backgroundCount; i++) {
+        float decrement = frameTime * (float)BACKGROUND_TEXTURE_SPEED;
+        float nextX = backgrounds[i].x - decrement;
+        if (nextX <= -(float)BOUNDARY_WIDTH) {
+            nextX = backgrounds[mod(i - 1, backgroundCount)].x + (float)BOUNDARY_WIDTH - decrement;
+        }
+
+        backgrounds[i].x = nextX;
+    }
+}
+
+void WorldInit(World* world, Physics physics, unsigned int seed) {
+    *world = (World){0};
+    world->physics = physics;
+    world->seed = seed;
+
+    WorldReset(world);
+    world->mode = INTRO;
+}
+
+void WorldReset(World* world) {
+    Physics* physics = &world->physics;
+
+    for (int i = 0; i < BACKGROUND_TEXTURE_COUNT; i++) {
+        world->backgrounds[i] = (Rectangle){
+            (float)i * (float)BOUNDARY_WIDTH,
+            0.0f,
+            (float)BOUNDARY_WIDTH,
+            (float)(BOUNDARY_HEIGHT - BOUNDARY_BOTTOM),
+        };
+    }
+    for (int i = 0; i < BASE_TEXTURE_COUNT; i++) {
+        world->bases[i] = (Rectangle){
+            (float)i * (float)BOUNDARY_WIDTH,
+            (float)(BOUNDARY_HEIGHT - BOUNDARY_BOTTOM),
+            (float)BOUNDARY_WIDTH,
+            (float)BOUNDARY_BOTTOM,
+        };
+    }
+
+    int frac = PHYSICS_OBSTACLE_FRAC(physics);
+    world->obstacles[0] = (Obstacle){0};
+    world->obstacles[0].position.y = GetNextOffset(frac / 2 + 1, physics);
+    world->obstacles[0].position.x = (float)BOUNDARY_WIDTH;
+    for (int i = 1; i < OBSTACLE_COUNT; i++) {
+        world->obstacles[i] = (Obstacle){0};
+        world->obstacles[i].position.y = GetNextOffset(frac / 2 + 1, physics);
+        world->obstacles[i].position.x =
+            world->obstacles[i - 1].position.x + OBSTACLE_WIDTH + PHYSICS_OBSTACLE_DISTANCE(physics);
+    }
+    ObstacleHitboxUpdate(world->obstacles, OBSTACLE_COUNT, physics);
+
+    world->bird = (Bird){0};
+    world->bird.center = (Vector2){(float)BOUNDARY_WIDTH / 2.0f, (float)BOUNDARY_HEIGHT / 2.0f};
+
+    world->score = BIRD_INITIAL_SCORE;
+}
+
+int WorldUpdate(World* world, int input, float frameTime) {
+    switch (world->mode) {
+        case INTRO:
+            return WorldIntroUpdate(world, input, frameTime);
+        case PLAY:
+            return WorldPlayUpdate(world, input, frameTime);
+        case OVER:
+            return WorldOverUpdate(world, input, frameTime);
+        default:
+            return WORLD_EVENT_NONE;
+    }
+}
+
+int WorldIntroUpdate(World* world, int input, float frameTime) {
+    if (!input) {
+        return WORLD_EVENT_NONE;
+    }
+
+    BirdUpdate(&world->bird, 1, frameTime, &world->physics);
+    world->mode = PLAY;
+
+    return WORLD_EVENT_NONE;
+}
+
+int WorldPlayUpdate(World* world, int input, float frameTime) {
+    int events = WORLD_EVENT_NONE;
+
+    BackgroundUpdate(world->backgrounds, BACKGROUND_TEXTURE_COUNT, frameTime);
+    BaseUpdate(world->bases, BASE_TEXTURE_COUNT, frameTime, &world->physics);
+
+    ObstacleUpdate(world, frameTime);
+
+    BirdUpdate(&world->bird, input, frameTime, &world->physics);
+    unsigned int passCount = BirdIsPassed(&world->bird, world->obstacles, OBSTACLE_COUNT);
+    if (passCount) {
+        world->score += passCount;
+        events |= WORLD_EVENT_POINT;
+    }
+    if (BirdIsCollide(&world->bird, world->obstacles, OBSTACLE_COUNT)) {
+        events |= WORLD_EVENT_HIT;
+#if BIRD_COLLISION
+        world->flashIntensity = FLASH_INITIAL_ALPHA;
+        world->mode = OVER;
+#endif
+    }
+
+    return events;
+}
+
+int WorldOverUpdate(World* world, int input, float frameTime) {
+    if (world->flashIntensity >= 0.0f) {
+        world->flashIntensity -= (float)FLASH_DECAY_SPEED * frameTime;
+    } else {
+        world->flashIntensity = 0.0f;
+    }
+
+    if (!input) {
+        return WORLD_EVENT_NONE;
+    }
+
+    WorldReset(world);
+    BirdUpdate(&world->bird, 1, frameTime, &world->physics);
+    world->mode = PLAY;
+
+    return WORLD_EVENT_NONE;
+}
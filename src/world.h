@@ -0,0 +1,127 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <raylib.h>
+
+/* Read the tuning below from World.physics instead of the compile-time constants. */
+#ifndef RUNTIME_PHYSICS
+#define RUNTIME_PHYSICS 0
+#endif
+
+#define BOUNDARY_TOP    0
+#define BOUNDARY_BOTTOM 100
+#define BOUNDARY_WIDTH  480
+#define BOUNDARY_HEIGHT 854
+
+#define BACKGROUND_TEXTURE_COUNT 2
+#define BACKGROUND_TEXTURE_SPEED 50
+
+#define BASE_TEXTURE_COUNT 2
+
+#define OBSTACLE_WIDTH    90
+#define OBSTACLE_HEIGHT   480
+#define OBSTACLE_PADDING  120
+#define OBSTACLE_MARGIN   180
+#define OBSTACLE_SPEED    170
+#define OBSTACLE_DISTANCE 240
+#define OBSTACLE_COUNT    2
+#define OBSTACLE_FRAC     5
+
+#define BIRD_HIT_RADIUS     20
+#define BIRD_JUMP_FORCE     470
+#define BIRD_ROTATION_SPEED 100
+#define BIRD_ROTATION_MIN   60 /* will be cast to negative */
+#define BIRD_ROTATION_MAX   60
+#define BIRD_INITIAL_SCORE  0
+#define BIRD_COLLISION      1
+
+#define FLASH_INITIAL_ALPHA 0.8f
+#define FLASH_DECAY_SPEED   17
+
+#define SIMULATION_GRAVITY 1500
+
+#define WORLD_DEFAULT_SEED 0x2545f491u
+
+#define WORLD_EVENT_NONE  0
+#define WORLD_EVENT_POINT 1
+#define WORLD_EVENT_HIT   2
+
+typedef enum {
+    INTRO,
+    PLAY,
+    OVER,
+} GameMode;
+
+typedef struct {
+    Vector2 position;
+    Rectangle pipeTop;
+    Rectangle pipeBottom;
+    int passed;
+} Obstacle;
+
+typedef struct {
+    Vector2 center;
+    float velocity;
+    float rotation;
+} Bird;
+
+typedef struct {
+    float gravity;
+    float jumpForce;
+    float obstacleSpeed;
+    float obstacleMargin;
+    float obstacleDistance;
+    int obstacleFrac;
+} Physics;
+
+#define PHYSICS_DEFAULT           \
+    (Physics){                    \
+        (float)SIMULATION_GRAVITY, \
+        (float)BIRD_JUMP_FORCE,    \
+        (float)OBSTACLE_SPEED,     \
+        (float)OBSTACLE_MARGIN,    \
+        (float)OBSTACLE_DISTANCE,  \
+        OBSTACLE_FRAC,             \
+    }
+
+#if RUNTIME_PHYSICS
+#define PHYSICS_GRAVITY(physics)           ((physics)->gravity)
+#define PHYSICS_JUMP_FORCE(physics)        ((physics)->jumpForce)
+#define PHYSICS_OBSTACLE_SPEED(physics)    ((physics)->obstacleSpeed)
+#define PHYSICS_OBSTACLE_MARGIN(physics)   ((physics)->obstacleMargin)
+#define PHYSICS_OBSTACLE_DISTANCE(physics) ((physics)->obstacleDistance)
+#define PHYSICS_OBSTACLE_FRAC(physics)     ((physics)->obstacleFrac)
+#else
+#define PHYSICS_GRAVITY(physics)           ((void)(physics), (float)SIMULATION_GRAVITY)
+#define PHYSICS_JUMP_FORCE(physics)        ((void)(physics), (float)BIRD_JUMP_FORCE)
+#define PHYSICS_OBSTACLE_SPEED(physics)    ((void)(physics), (float)OBSTACLE_SPEED)
+#define PHYSICS_OBSTACLE_MARGIN(physics)   ((void)(physics), (float)OBSTACLE_MARGIN)
+#define PHYSICS_OBSTACLE_DISTANCE(physics) ((void)(physics), (float)OBSTACLE_DISTANCE)
+#define PHYSICS_OBSTACLE_FRAC(physics)     ((void)(physics), OBSTACLE_FRAC)
+#endif
+
+/* Everything the simulation touches, no textures or sounds, so it can run headless. */
+typedef struct {
+    GameMode mode;
+    unsigned int score;
+    unsigned int seed;
+
+    Rectangle backgrounds[BACKGROUND_TEXTURE_COUNT];
+    Rectangle bases[BASE_TEXTURE_COUNT];
+    float flashIntensity;
+
+    Obstacle obstacles[OBSTACLE_COUNT];
+    Bird bird;
+
+    Physics physics;
+} World;
+
+void WorldInit(World* world, Physics physics, unsigned int seed);
+void WorldReset(World* world);
+int WorldUpdate(World* world, int input, float frameTime);
+
+int WorldIntroUpdate(World* world, int input, float frameTime);
+int WorldPlayUpdate(World* world, int input, float frameTime);
+int WorldOverUpdate(World* world, int input, float frameTime);
+
+#endif
@@ -0,0 +1,421 @@
+/*
+ * Headless difficulty sweep. Runs a bot through every combination of the given physics ranges on all cores and
+ * prints the score distribution and survival curve of each setting as CSV.
+ *
+ * Build with the world compiled using -DRUNTIME_PHYSICS=1 (see the `sweep` target of the desktop Makefile).
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "world.h"
+
+#if !RUNTIME_PHYSICS
+#error "The sweep needs the world built with RUNTIME_PHYSICS=1."
+#endif
+
+#define SWEEP_FRAME_TIME   (1.0f / 60.0f)
+#define SWEEP_MAX_SECONDS  120.0f
+#define SWEEP_RUNS         200
+#define SWEEP_AIM_ERROR    30.0f
+#define SWEEP_SEED         1u
+#define SWEEP_CHUNK        16
+#define SWEEP_AXIS_COUNT   6
+#define SWEEP_AXIS_MAX_LEN 64
+
+typedef struct {
+    const char* name;
+    float values[SWEEP_AXIS_MAX_LEN];
+    int count;
+} Axis;
+
+typedef struct {
+    Axis axes[SWEEP_AXIS_COUNT];
+    int settingCount;
+    int runCount;
+    float aimError;
+    int frameLimit; /* frames before a run is capped */
+    unsigned int seed;
+
+    unsigned int* scores; /* settingCount * runCount, a capped run keeps the score it reached */
+    int* capped;
+
+    pthread_mutex_t lock;
+    int nextJob;
+} Sweep;
+
+typedef struct {
+    unsigned int seed;
+    float aimError;
+    float aim;
+    int target;
+} Bot;
+
+unsigned int Hash(unsigned int x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x ? x : 1u;
+}
+
+float BotRandom(Bot* bot) {
+    bot->seed ^= bot->seed << 13;
+    bot->seed ^= bot->seed >> 17;
+    bot->seed ^= bot->seed << 5;
+    return (float)(bot->seed & 0xffffff) / (float)0xffffff;
+}
+
+/* Flap when falling below the gap, aiming so the jump apex lands inside it, with a fresh aim error per pipe. */
+int BotInput(Bot* bot, World* world) {
+    Physics* physics = &world->physics;
+    Bird* bird = &world->bird;
+
+    int target = -1;
+    for (int i = 0; i < OBSTACLE_COUNT; i++) {
+        Obstacle* obstacle = &world->obstacles[i];
+        if (obstacle->position.x + (float)OBSTACLE_WIDTH < bird->center.x - (float)BIRD_HIT_RADIUS) {
+            continue;
+        }
+        if (target < 0 || obstacle->position.x < world->obstacles[target].position.x) {
+            target = i;
+        }
+    }
+    if (target < 0) {
+        return 0;
+    }
+    if (target != bot->target) {
+        bot->target = target;
+        bot->aim = (BotRandom(bot) * 2.0f - 1.0f) * bot->aimError;
+    }
+
+    float jump = PHYSICS_JUMP_FORCE(physics);
+    float apex = (jump * jump) / (2.0f * PHYSICS_GRAVITY(physics));
+    float gapCenter = world->obstacles[target].position.y + (PHYSICS_OBSTACLE_MARGIN(physics) / 2.0f);
+
+    return bird->velocity >= 0.0f && bird->center.y > gapCenter + (apex / 2.0f) + bot->aim;
+}
+
+Physics SweepPhysics(Sweep* sweep, int setting) {
+    int index[SWEEP_AXIS_COUNT];
+    for (int a = SWEEP_AXIS_COUNT - 1; a >= 0; a--) {
+        index[a] = setting % sweep->axes[a].count;
+        setting /= sweep->axes[a].count;
+    }
+
+    return (Physics){
+        sweep->axes[0].values[index[0]],
+        sweep->axes[1].values[index[1]],
+        sweep->axes[2].values[index[2]],
+        sweep->axes[3].values[index[3]],
+        sweep->axes[4].values[index[4]],
+        (int)sweep->axes[5].values[index[5]],
+    };
+}
+
+void SweepRun(Sweep* sweep, int job) {
+    Physics physics = SweepPhysics(sweep, job / sweep->runCount);
+
+    /* Same seeds for the same run index, so every setting faces the same courses and bot mistakes. */
+    int run = job % sweep->runCount;
+    World world;
+    /* Course and bot take separate streams per run, and a new seed does not replay shifted runs of the old one. */
+    unsigned int base = Hash(sweep->seed);
+    WorldInit(&world, physics, Hash(base ^ (2u * (unsigned int)run)));
+    Bot bot = (Bot){Hash(base ^ (2u * (unsigned int)run + 1u)), sweep->aimError, 0.0f, -1};
+
+    WorldUpdate(&world, 1, SWEEP_FRAME_TIME);
+    for (int frame = 0; frame < sweep->frameLimit && world.mode == PLAY; frame++) {
+        WorldUpdate(&world, BotInput(&bot, &world), SWEEP_FRAME_TIME);
+    }
+
+    sweep->scores[job] = world.score;
+    sweep->capped[job] = world.mode == PLAY;
+}
+
+void* SweepWorker(void* data) {
+    Sweep* sweep = data;
+    int jobCount = sweep->settingCount * sweep->runCount;
+
+    for (;;) {
+        /* nextJob stops at the first chunk past the end, so it never grows beyond jobCount + SWEEP_CHUNK. */
+        pthread_mutex_lock(&sweep->lock);
+        int job = sweep->nextJob;
+        if (job < jobCount) {
+            sweep->nextJob += SWEEP_CHUNK;
+        }
+        pthread_mutex_unlock(&sweep->lock);
+
+        if (job >= jobCount) {
+            break;
+        }
+        for (int end = job + SWEEP_CHUNK; job < end && job < jobCount; job++) {
+            SweepRun(sweep, job);
+        }
+    }
+
+    return NULL;
+}
+
+/* Accepts `value`, `min:max` or `min:max:step`, with at most SWEEP_AXIS_MAX_LEN values. */
+int AxisParse(Axis* axis, const char* text) {
+    float min = 0.0f;
+    float max = 0.0f;
+    float step = 0.0f;
+    int parsed = sscanf(text, "%f:%f:%f", &min, &max, &step);
+    if (parsed < 1) {
+        return 0;
+    }
+    if (parsed == 1) {
+        max = min;
+    }
+    if (parsed < 3) {
+        step = max - min;
+    }
+    if (max < min || (max > min && step <= 0.0f)) {
+        return 0;
+    }
+
+    if (max > min && floorf((max - min) / step + 0.001f) + 1.0f > (float)SWEEP_AXIS_MAX_LEN) {
+        return 0;
+    }
+
+    axis->count = 0;
+    for (float value = min; axis->count < SWEEP_AXIS_MAX_LEN; value += step) {
+        if (value > max + (step * 0.001f)) {
+            break;
+        }
+        axis->values[axis->count++] = value;
+        if (step <= 0.0f) {
+            break;
+        }
+    }
+
+    return 1;
+}
+
+/* Every value must be above `bound`, and a whole number if `integer` is set. */
+int AxisCheck(Axis* axis, float bound, int integer) {
+    for (int i = 0; i < axis->count; i++) {
+        if (axis->values[i] <= bound || (integer && axis->values[i] != floorf(axis->values[i]))) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int CompareScore(const void* a, const void* b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    return (x > y) - (x < y);
+}
+
+void SweepPrint(Sweep* sweep) {
+    printf("gravity,jump_force,obstacle_speed,obstacle_margin,obstacle_distance,obstacle_frac,score,count,survival\n");
+
+    unsigned int* sorted = malloc(sizeof(*sorted) * (size_t)sweep->runCount);
+    for (int setting = 0; setting < sweep->settingCount; setting++) {
+        unsigned int* scores = &sweep->scores[setting * sweep->runCount];
+        memcpy(sorted, scores, sizeof(*sorted) * (size_t)sweep->runCount);
+        qsort(sorted, (size_t)sweep->runCount, sizeof(*sorted), CompareScore);
+
+        char prefix[128];
+        Physics physics = SweepPhysics(sweep, setting);
+        snprintf(
+            prefix,
+            sizeof(prefix),
+            "%g,%g,%g,%g,%g,%d",
+            physics.gravity,
+            physics.jumpForce,
+            physics.obstacleSpeed,
+            physics.obstacleMargin,
+            physics.obstacleDistance,
+            physics.obstacleFrac
+        );
+
+        /* One row per score: how many runs ended exactly there and the fraction that got at least that far. */
+        for (int i = 0; i < sweep->runCount;) {
+            int j = i;
+            for (; j < sweep->runCount && sorted[j] == sorted[i]; j++) {
+            }
+            printf(
+                "%s,%u,%d,%.4f\n", prefix, sorted[i], j - i, (float)(sweep->runCount - i) / (float)sweep->runCount
+            );
+            i = j;
+        }
+
+        int capped = 0;
+        double total = 0.0;
+        for (int i = 0; i < sweep->runCount; i++) {
+            capped += sweep->capped[setting * sweep->runCount + i];
+            total += sorted[i];
+        }
+        fprintf(
+            stderr,
+            "%s: mean %.2f, p10 %u, median %u, p90 %u, capped %d/%d\n",
+            prefix,
+            total / (double)sweep->runCount,
+            sorted[sweep->runCount / 10],
+            sorted[sweep->runCount / 2],
+            sorted[(sweep->runCount * 9) / 10],
+            capped,
+            sweep->runCount
+        );
+    }
+    free(sorted);
+}
+
+void Usage(const char* program) {
+    fprintf(
+        stderr,
+        "usage: %s [-g gravity] [-j jump] [-s speed] [-m margin] [-d distance] [-f frac]\n"
+        "          [-n runs] [-t threads] [-e aim-error] [-T max-seconds] [-S seed]\n"
+        "Physics options take `value`, `min:max` or `min:max:step`; unset ones keep the game defaults.\n",
+        program
+    );
+}
+
+int main(int argc, char** argv) {
+    static Sweep sweep;
+    Physics defaults = PHYSICS_DEFAULT;
+    const char* names[SWEEP_AXIS_COUNT] = {"gravity", "jump", "speed", "margin", "distance", "frac"};
+    float values[SWEEP_AXIS_COUNT] = {
+        defaults.gravity,
+        defaults.jumpForce,
+        defaults.obstacleSpeed,
+        defaults.obstacleMargin,
+        defaults.obstacleDistance,
+        (float)defaults.obstacleFrac,
+    };
+    for (int a = 0; a < SWEEP_AXIS_COUNT; a++) {
+        sweep.axes[a] = (Axis){names[a], {values[a]}, 1};
+    }
+    sweep.runCount = SWEEP_RUNS;
+    sweep.aimError = SWEEP_AIM_ERROR;
+    double maxSeconds = SWEEP_MAX_SECONDS;
+    sweep.seed = SWEEP_SEED;
+    long threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+    int option;
+    while ((option = getopt(argc, argv, "g:j:s:m:d:f:n:t:e:T:S:h")) != -1) {
+        const char* axes = "gjsmdf";
+        const char* axis = strchr(axes, option);
+        if (axis) {
+            if (!AxisParse(&sweep.axes[axis - axes], optarg)) {
+                fprintf(
+                    stderr,
+                    "invalid range for %s: %s (at most %d values)\n",
+                    sweep.axes[axis - axes].name,
+                    optarg,
+                    SWEEP_AXIS_MAX_LEN
+                );
+                return 1;
+            }
+            continue;
+        }
+        switch (option) {
+            case 'n':
+                sweep.runCount = atoi(optarg);
+                break;
+            case 't':
+                threadCount = atol(optarg);
+                break;
+            case 'e':
+                sweep.aimError = (float)atof(optarg);
+                break;
+            case 'T':
+                maxSeconds = atof(optarg);
+                break;
+            case 'S':
+                sweep.seed = (unsigned int)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                Usage(argv[0]);
+                return option == 'h' ? 0 : 1;
+        }
+    }
+    if (sweep.runCount <= 0 || threadCount <= 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+    if (!(maxSeconds > 0.0) || maxSeconds / SWEEP_FRAME_TIME >= (double)INT_MAX) {
+        fprintf(stderr, "max-seconds must be above 0 and below %.0f\n", (double)INT_MAX * SWEEP_FRAME_TIME);
+        return 1;
+    }
+    sweep.frameLimit = (int)(maxSeconds / SWEEP_FRAME_TIME);
+
+    /* The bot divides by gravity, and frac divides the gap area and bounds the random pipe offset. */
+    if (!AxisCheck(&sweep.axes[0], 0.0f, 0)) {
+        fprintf(stderr, "gravity must be above 0\n");
+        return 1;
+    }
+    if (!AxisCheck(&sweep.axes[5], 0.0f, 1)) {
+        fprintf(stderr, "frac must be a whole number of at least 1\n");
+        return 1;
+    }
+
+    /* Jobs are indexed with int, leave room for the one chunk nextJob may step past the end. */
+    long long jobLimit = (long long)sweep.runCount;
+    sweep.settingCount = 1;
+    for (int a = 0; a < SWEEP_AXIS_COUNT; a++) {
+        sweep.settingCount *= sweep.axes[a].count;
+        jobLimit *= sweep.axes[a].count;
+        if (jobLimit > INT_MAX - SWEEP_CHUNK) {
+            fprintf(stderr, "too many settings x runs\n");
+            return 1;
+        }
+    }
+    size_t jobCount = (size_t)sweep.settingCount * (size_t)sweep.runCount;
+    sweep.scores = calloc(jobCount, sizeof(*sweep.scores));
+    sweep.capped = calloc(jobCount, sizeof(*sweep.capped));
+    pthread_t* threads = calloc((size_t)threadCount, sizeof(*threads));
+    if (!sweep.scores || !sweep.capped || !threads) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    pthread_mutex_init(&sweep.lock, NULL);
+
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < threadCount; i++) {
+        if (pthread_create(&threads[i], NULL, SweepWorker, &sweep) != 0) {
+            if (i == 0) {
+                fprintf(stderr, "could not start any threads\n");
+                return 1;
+            }
+            fprintf(stderr, "could only start %ld of %ld threads\n", i, threadCount);
+            threadCount = i;
+            break;
+        }
+    }
+    for (long i = 0; i < threadCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    SweepPrint(&sweep);
+    fprintf(
+        stderr,
+        "%d settings x %d runs on %ld threads in %.2fs\n",
+        sweep.settingCount,
+        sweep.runCount,
+        threadCount,
+        (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9
+    );
+
+    pthread_mutex_destroy(&sweep.lock);
+    free(threads);
+    free(sweep.capped);
+    free(sweep.scores);
+
+    return 0;
+}